@@ -32,18 +32,35 @@
 #include <math.h>
 #include <assert.h>
 
-#define SAFE_RELEASE(x) \
-    do { \
-        if ((x)) { \
-            free((x)); \
-            (x) = 0; \
-        } \
-    } while (0)
+#include "../common/common.h"
+#include "../common/fastio.h"
+
+#ifdef BN_THREADS
+#include "../common/thread_pool.h"
+#endif
 
 #ifndef max
 #define max(x, y) ((x) > (y) ? (x) : (y))
 #endif
 
+#ifndef min
+#define min(x, y) ((x) < (y) ? (x) : (y))
+#endif
+
+// factors with at least this many digits (the shorter one) are multiplied by
+// the column kernel, whose column blocks are spread over the thread pool
+#ifndef BN_MUL_COLUMN_CUTOFF
+#define BN_MUL_COLUMN_CUTOFF 64
+#endif
+
+// column blocks handed out per thread, more blocks balance the uneven columns
+#define BN_MUL_BLOCKS_PER_THREAD 16
+#define BN_MUL_MIN_BLOCK_COLUMNS 32
+
+// terms summed in 32 bits before spilling into the 64 bit column sum,
+// 81 * 2^24 still fits in 32 bits
+#define BN_MUL_TERMS_PER_SPILL (1 << 24)
+
 typedef unsigned short digit;
 typedef unsigned long twodigits;
 
@@ -89,8 +106,9 @@ static void bn_print(big_number_t* bn)
         if (*p == '.') --p;
         ++p;
     }
-    *p = '\0';
-    printf("%s%s\n", bn->negative ? "-" : "", repr);
+    if (bn->negative) fio_put_char('-');
+    fio_put_mem(repr, (size_t)(p - repr));
+    fio_put_char('\n');
 
     SAFE_RELEASE(repr);
 }
@@ -155,6 +173,99 @@ static bool bn_is_zero(big_number_t* x)
     return (x->num_of_digits == 1 && x->digits[0] == 0);
 }
 
+#ifdef BN_THREADS
+static thread_pool_t* s_bn_pool;
+#endif
+
+typedef struct __bn_mul_columns {
+    const digit* x;
+    size_t nx;
+    const digit* ry;        // digits of y in reversed order
+    size_t ny;
+    uint64_t* columns;      // column sums before carrying, nx + ny - 1 of them
+    size_t num_columns;
+    size_t block_size;
+} bn_mul_columns_t;
+
+// sum x[i] * y[k - i] over every i for the columns k of one block
+static void bn_mul_column_block(void* ctx, size_t index)
+{
+    const bn_mul_columns_t* c = (const bn_mul_columns_t*)ctx;
+    size_t k = index * c->block_size;
+    size_t k_end = min(k + c->block_size, c->num_columns);
+
+    for (; k < k_end; ++k) {
+        size_t i = k >= c->ny - 1 ? k - (c->ny - 1) : 0;
+        size_t terms = min(k, c->nx - 1) + 1 - i;
+        // y[k - i] == ry[i + ny - 1 - k], so both factors are walked forward
+        // from the first term, whose index i + ny - 1 - k is never negative
+        const digit* px = c->x + i;
+        const digit* py = c->ry + (i + c->ny - 1 - k);
+
+        uint64_t sum = 0;
+        size_t j = 0;
+        while (j < terms) {
+            size_t stop = min(terms, j + BN_MUL_TERMS_PER_SPILL);
+            uint32_t part = 0;
+            for (; j < stop; ++j) {
+                part += (uint32_t)px[j] * py[j];
+            }
+            sum += part;
+        }
+        c->columns[k] = sum;
+    }
+}
+
+// z = x * y by whole columns, z must have room for nx + ny digits
+static bool bn_mul_columns(const digit* x, size_t nx, const digit* y, size_t ny, digit* z)
+{
+    size_t num_columns = nx + ny - 1;
+    uint64_t* columns = (uint64_t*) malloc(sizeof(uint64_t) * num_columns);
+    digit* ry = (digit*) malloc(sizeof(digit) * ny);
+    if (!columns || !ry) {
+        SAFE_RELEASE(columns);
+        SAFE_RELEASE(ry);
+        return false;
+    }
+
+    size_t i;
+    for (i = 0; i < ny; ++i) {
+        ry[i] = y[ny - 1 - i];
+    }
+
+    bn_mul_columns_t c;
+    c.x = x;
+    c.nx = nx;
+    c.ry = ry;
+    c.ny = ny;
+    c.columns = columns;
+    c.num_columns = num_columns;
+
+#ifdef BN_THREADS
+    size_t num_blocks = tp_size(s_bn_pool) * BN_MUL_BLOCKS_PER_THREAD;
+    c.block_size = max((num_columns + num_blocks - 1) / num_blocks, BN_MUL_MIN_BLOCK_COLUMNS);
+    num_blocks = (num_columns + c.block_size - 1) / c.block_size;
+    tp_run(s_bn_pool, num_blocks, bn_mul_column_block, &c);
+#else
+    c.block_size = num_columns;
+    bn_mul_column_block(&c, 0);
+#endif
+
+    // carry serially, so the result never depends on how columns were split;
+    // as wide as the column sums, twodigits is only 32 bits on ILP32 and LLP64
+    uint64_t carry = 0;
+    for (i = 0; i < num_columns; ++i) {
+        carry += columns[i];
+        z[i] = (digit)(carry % 10);
+        carry /= 10;
+    }
+    z[num_columns] = (digit)carry;
+
+    SAFE_RELEASE(columns);
+    SAFE_RELEASE(ry);
+    return true;
+}
+
 static big_number_t* bn_mul(big_number_t* x, big_number_t* y)
 {
     if (!x || !y) return 0;
@@ -166,21 +277,29 @@ static big_number_t* bn_mul(big_number_t* x, big_number_t* y)
     if (!z) return 0;
 
     size_t i;
-    for (i = 0; i < x->num_of_digits; ++i) {
-        twodigits carry = 0;
-        twodigits f = x->digits[i];
-        digit* pz = z->digits + i;
-        digit* py = y->digits;
-        digit* py_end = py + y->num_of_digits;
-
-        while (py < py_end) {
-            carry += *pz + *py++ * f;
-            *pz++ = (digit)(carry % 10);
-            carry /= 10;
+    if (min(x->num_of_digits, y->num_of_digits) >= BN_MUL_COLUMN_CUTOFF) {
+        if (!bn_mul_columns(x->digits, x->num_of_digits, y->digits, y->num_of_digits, z->digits)) {
+            SAFE_RELEASE(z);
+            return 0;
         }
-
-        if (carry) {
-            *pz += (digit)(carry);
+    }
+    else {
+        for (i = 0; i < x->num_of_digits; ++i) {
+            twodigits carry = 0;
+            twodigits f = x->digits[i];
+            digit* pz = z->digits + i;
+            digit* py = y->digits;
+            digit* py_end = py + y->num_of_digits;
+
+            while (py < py_end) {
+                carry += *pz + *py++ * f;
+                *pz++ = (digit)(carry % 10);
+                carry /= 10;
+            }
+
+            if (carry) {
+                *pz += (digit)(carry);
+            }
         }
     }
 
@@ -213,10 +332,13 @@ static big_number_t* bn_pow(big_number_t* base, long power)
             SAFE_RELEASE(r);
             r = tmp;
         }
+        power /= 2;
+        // the last squaring is the biggest multiplication, skip it when unused
+        if (power == 0) break;
+
         big_number_t* tmp = bn_mul(b, b);
         SAFE_RELEASE(b);
         b = tmp;
-        power /= 2;
     }
     SAFE_RELEASE(b);
     return r;
@@ -245,26 +367,59 @@ static void conv_str_to_decimal(char* str, int* decimal, size_t* shift)
     SAFE_RELEASE(str_decimal);
 }
 
-static void calc_pow()
+typedef struct __pow_query {
+    char base[7];
+    long power;
+    big_number_t* result;
+} pow_query_t;
+
+static inline bool parse_query(pow_query_t* q)
+{
+    return fio_read_token(q->base, sizeof(q->base)) != -1 && fio_read_long(&q->power);
+}
+
+static inline void calc_pow(pow_query_t* q)
 {
-    char str_base[7] = { '\0' };
     int decimal = 0;
     size_t shift = 0;
-    int power = 0;
-
-    while (scanf("%s %d", str_base, &power) != EOF) {
-        conv_str_to_decimal(str_base, &decimal, &shift);
-        big_number_t* bn = create_big_number_from_long((long)decimal, shift);
-        big_number_t* exp = bn_pow(bn, power);
-        bn_print(exp);
-        SAFE_RELEASE(bn);
-        SAFE_RELEASE(exp);
-    }
+
+    conv_str_to_decimal(q->base, &decimal, &shift);
+    big_number_t* bn = create_big_number_from_long((long)decimal, shift);
+    q->result = bn_pow(bn, q->power);
+    SAFE_RELEASE(bn);
+}
+
+static inline void emit_result(pow_query_t* q)
+{
+    bn_print(q->result);
+    SAFE_RELEASE(q->result);
 }
 
-int main()
+#ifdef BN_THREADS
+// BN_THREADS threads share one multiplication, 0 for one per online CPU
+static inline void bn_init()
 {
-    calc_pow();
-    return 0;
+    s_bn_pool = tp_create(BN_THREADS);
 }
 
+static inline void bn_fini()
+{
+    tp_destroy(s_bn_pool);
+    s_bn_pool = 0;
+}
+
+#define HARNESS_BEGIN()         bn_init()
+#define HARNESS_END()           bn_fini()
+
+// multiplications inside a harness task would run serially, the threads go to
+// the multiplications of one item at a time instead
+#if defined(HARNESS_THREADS) && HARNESS_THREADS != 1
+#error "BN_THREADS and HARNESS_THREADS cannot be combined, use BN_THREADS alone"
+#endif
+#endif // BN_THREADS
+
+#define HARNESS_ITEM            pow_query_t
+#define HARNESS_PARSE(q)        parse_query(q)
+#define HARNESS_COMPUTE(q)      calc_pow(q)
+#define HARNESS_EMIT(q)         emit_result(q)
+#include "../common/harness.h"
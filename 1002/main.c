@@ -60,16 +60,12 @@
 #include <stdio.h>
 #include <math.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 
-#define SAFE_RELEASE(x) \
-    do { \
-        if ((x)) { \
-            free((x)); \
-            (x) = 0; \
-        } \
-    } while (0)
+#include "../common/common.h"
+#include "../common/fastio.h"
 
 typedef struct __dup_num {
     uint32_t number;
@@ -93,7 +89,7 @@ static int compare(const void* x, const void* y)
 static void output_duplicated_numbers(slist_t* list)
 {
     if (!list) {
-        printf("No duplicates.\n");
+        fio_put_str("No duplicates.\n");
         return;
     }
 
@@ -101,7 +97,12 @@ static void output_duplicated_numbers(slist_t* list)
     while (l) {
         dup_num_t* p = (dup_num_t*)(l->data);
         assert(p && "duplicate number is NULL");
-        printf("%03u-%04u %u\n", p->number / 10000, p->number % 10000, p->count);
+        fio_put_u32_width(p->number / 10000, 3);
+        fio_put_char('-');
+        fio_put_u32_width(p->number % 10000, 4);
+        fio_put_char(' ');
+        fio_put_u32(p->count);
+        fio_put_char('\n');
         l = l->next;
     }
 }
@@ -249,36 +250,53 @@ static void dump_numbers(uint32_t* numbers, size_t count)
     printf("\n");
 }
 
-static void check_phone_numbers()
+typedef struct __phone_number {
+    char str_number[64];
+    uint32_t number;
+} phone_number_t;
+
+static uint32_t* s_numbers;
+static uint32_t s_num_of_lines;
+static uint32_t s_num_of_parsed;
+static size_t s_count;
+
+static inline void read_directory_size()
 {
-    uint32_t num_of_lines = 0;
-    scanf("%u", &num_of_lines);
+    fio_read_u32(&s_num_of_lines);
+    if (s_num_of_lines < 2) return;
 
-    if (num_of_lines < 2) {
-        output_duplicated_numbers(0);
-        return;
-    }
+    s_numbers = (uint32_t*)malloc(sizeof(uint32_t) * s_num_of_lines);
+    assert(s_numbers && "Failed to allocate memory for input numbers");
+}
 
-    uint32_t* numbers = (uint32_t*)malloc(sizeof(uint32_t) * num_of_lines);
-    assert(numbers && "Failed to allocate memory for input numbers");
-    memset(numbers, 0, sizeof(uint32_t) * num_of_lines);
+static inline bool read_phone_number(phone_number_t* n)
+{
+    if (!s_numbers || s_num_of_parsed >= s_num_of_lines) return false;
+    if (fio_read_token(n->str_number, sizeof(n->str_number)) == -1) return false;
 
-    char str_number[64] = { '\0' };
-    uint32_t* p = numbers;
-    size_t count = 0;
-    while (scanf("%s", str_number) != EOF && count < num_of_lines) {
-        *p++ = normalize_number(str_number);
-        ++count;
-        memset(str_number, 0, sizeof(str_number));
+    ++s_num_of_parsed;
+    return true;
+}
+
+static inline void store_phone_number(phone_number_t* n)
+{
+    s_numbers[s_count++] = n->number;
+}
+
+static inline void check_phone_numbers()
+{
+    if (!s_numbers) {
+        output_duplicated_numbers(0);
+        return;
     }
 
-    //dump_numbers(numbers, count);
-    qsort(numbers, count, sizeof(uint32_t), compare);
-    //dump_numbers(numbers, count);
-    slist_t* dup_nums = pick_duplicated_numbers(numbers, count);
+    //dump_numbers(s_numbers, s_count);
+    qsort(s_numbers, s_count, sizeof(uint32_t), compare);
+    //dump_numbers(s_numbers, s_count);
+    slist_t* dup_nums = pick_duplicated_numbers(s_numbers, s_count);
     output_duplicated_numbers(dup_nums);
 
-    SAFE_RELEASE(numbers);
+    SAFE_RELEASE(s_numbers);
     slist_t* l = dup_nums;
     while (l) {
         dup_num_t* p = (dup_num_t*)(l->data);
@@ -289,9 +307,10 @@ static void check_phone_numbers()
     }
 }
 
-int main()
-{
-    check_phone_numbers();
-    return 0;
-}
-
+#define HARNESS_ITEM            phone_number_t
+#define HARNESS_BEGIN()         read_directory_size()
+#define HARNESS_PARSE(n)        read_phone_number(n)
+#define HARNESS_COMPUTE(n)      ((n)->number = normalize_number((n)->str_number))
+#define HARNESS_EMIT(n)         store_phone_number(n)
+#define HARNESS_END()           check_phone_numbers()
+#include "../common/harness.h"
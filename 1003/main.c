@@ -33,8 +33,36 @@
 #include <string.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <stdbool.h>
 
-static uint32_t s_guess_times;
+#include "../common/fastio.h"
+
+// c is read in thousandths, so a value with more digits than the problem
+// allows still takes the computed path instead of being truncated
+#define CARD_LENGTH_SCALE       3
+#define CARD_LENGTH_DIVISOR     1000
+
+// the problem bounds c to [0.01, 5.20] with exactly three digits, so every valid
+// query is one of 520 lengths in hundredths, answered from a table generated at
+// build time (see CMakeLists.txt); anything else is computed
+#define CARD_TABLE_MIN          1
+#define CARD_TABLE_MAX          520
+#define CARD_TABLE_STEP         (CARD_LENGTH_DIVISOR / 100)
+
+#ifdef CARD_TABLE
+#include "card_table.h"
+#endif
+
+typedef struct __card_query {
+    int64_t thousandths;
+    uint32_t cards;
+#ifdef PERF_MEASURE
+    uint32_t guess_times;
+#endif // PERF_MEASURE
+} card_query_t;
+
+// per thread, queries may be computed concurrently by the harness
+static __thread uint32_t s_guess_times;
 
 static uint32_t reset_guess_times()
 {
@@ -43,13 +71,16 @@ static uint32_t reset_guess_times()
     return r;
 }
 
-static void output_result(uint32_t n)
+static inline void output_result(card_query_t* q)
 {
-    printf("%u card(s)", n);
+    fio_put_u32(q->cards);
+    fio_put_str(" card(s)");
 #ifdef PERF_MEASURE
-    printf(", guessed %u time(s)", reset_guess_times());
+    fio_put_str(", guessed ");
+    fio_put_u32(q->guess_times);
+    fio_put_str(" time(s)");
 #endif // PERF_MEASURE
-    printf("\n");
+    fio_put_char('\n');
 }
 
 static double calculate(uint32_t n)
@@ -63,65 +94,112 @@ static double calculate(uint32_t n)
     return r;
 }
 
-static void guess_card_number()
+static inline bool read_query(card_query_t* q)
 {
-    char str_length[4] = { '\0' };
+    if (!fio_read_fixed(&q->thousandths, CARD_LENGTH_SCALE)) return false;
+    return q->thousandths != 0;
+}
+
+static uint32_t guess_card_number(double length)
+{
+    if (length <= 0.5) {
+        // minimum length is 0.5 for one card
+        // so any number no greater than 0.5 must be one card
+        return 1;
+    }
+
+    // take a guess since 2 cards
+    uint32_t guess = 2;
+    uint32_t prev_guess = 1;
+
     while (1) {
-        if (scanf("%s", str_length) == EOF) break;
-        if (strcmp(str_length, "0.00") == 0) break;
-        
-        double length = atof(str_length);
-        if (length <= 0.5) {
-            // minimum length is 0.5 for one card
-            // so any number no greater than 0.5 must be one card
-            output_result(1);
+        double guess_length = calculate(guess);
+        if (guess_length == length) {
+            break;
+        }
+        else if (guess_length < length) {
+            prev_guess = guess;
+            guess *= 2;
         }
         else {
-            // take a guess since 2 cards
-            uint32_t guess = 2;
-            uint32_t prev_guess = 1;
-            
-            while (1) {
-                double guess_length = calculate(guess);
+            uint32_t low_bound = prev_guess;
+            uint32_t high_bound = guess;
+
+            guess = (low_bound + high_bound) / 2;
+            while (guess > low_bound) {
+                guess_length = calculate(guess);
                 if (guess_length == length) {
                     break;
                 }
                 else if (guess_length < length) {
-                    prev_guess = guess;
-                    guess *= 2;
+                    low_bound = guess;
                 }
                 else {
-                    uint32_t low_bound = prev_guess;
-                    uint32_t high_bound = guess;
-
-                    guess = (low_bound + high_bound) / 2;
-                    while (guess > low_bound) {
-                        guess_length = calculate(guess);
-                        if (guess_length == length) {
-                            break;
-                        }
-                        else if (guess_length < length) {
-                            low_bound = guess;
-                        }
-                        else {
-                            high_bound = guess;
-                        }
-                        guess = (low_bound + high_bound) / 2;
-                    }
-
-                    if (guess == low_bound) ++guess;
-
-                    break;
+                    high_bound = guess;
                 }
+                guess = (low_bound + high_bound) / 2;
             }
-            output_result(guess);
+
+            if (guess == low_bound) ++guess;
+
+            break;
         }
     }
+    return guess;
 }
 
-int main()
+static inline void solve_query(card_query_t* q)
 {
-    guess_card_number();
-    return 0;
+#ifdef CARD_TABLE
+    if (q->thousandths % CARD_TABLE_STEP == 0) {
+        int64_t hundredths = q->thousandths / CARD_TABLE_STEP;
+        if (hundredths >= CARD_TABLE_MIN && hundredths <= CARD_TABLE_MAX) {
+            q->cards = s_card_table[hundredths];
+#ifdef PERF_MEASURE
+            q->guess_times = 0;
+#endif // PERF_MEASURE
+            return;
+        }
+    }
+#endif // CARD_TABLE
+
+    q->cards = guess_card_number((double)q->thousandths / CARD_LENGTH_DIVISOR);
+#ifdef PERF_MEASURE
+    q->guess_times = reset_guess_times();
+#endif // PERF_MEASURE
 }
 
+#ifdef CARD_TABLE_GENERATOR
+// writes card_table.h, answering every length of the table by the computed path
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <card_table.h>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* f = fopen(argv[1], "w");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(f, "// generated by poj_1003_card_table, do not edit\n\n");
+    fprintf(f, "static const uint16_t s_card_table[%d] = {\n    0,", CARD_TABLE_MAX + 1);
+    int c;
+    for (c = CARD_TABLE_MIN; c <= CARD_TABLE_MAX; ++c) {
+        // same double as the computed path gets for this length
+        uint32_t cards = guess_card_number((double)(c * CARD_TABLE_STEP) / CARD_LENGTH_DIVISOR);
+        fprintf(f, "%s%3u,", (c % 16 == 0) ? "\n    " : " ", cards);
+    }
+    fprintf(f, "\n};\n");
+
+    return fclose(f) == 0 ? 0 : 1;
+}
+#else
+#define HARNESS_ITEM            card_query_t
+#define HARNESS_PARSE(q)        read_query(q)
+#define HARNESS_COMPUTE(q)      solve_query(q)
+#define HARNESS_EMIT(q)         output_result(q)
+#include "../common/harness.h"
+#endif // CARD_TABLE_GENERATOR
@@ -30,23 +30,40 @@
 #include <assert.h>
 #include <string.h>
 #include <math.h>
+#include <inttypes.h>
+#include <stdbool.h>
 
-static void mean()
+#include "../common/fastio.h"
+
+typedef struct __balance {
+    int64_t cents;
+} balance_t;
+
+// balances are given to the penny, so sum them exactly in cents
+static int64_t s_total;
+
+static inline bool read_balance(balance_t* b)
+{
+    return fio_read_fixed(&b->cents, 2);
+}
+
+static inline void add_balance(balance_t* b)
 {
-    double r = 0.0;
-    double balance = 0.0;
-    while (scanf("%lf", &balance) != EOF) {
-        r += balance;
-        //printf("balance = %.2lf, total = %.2lf\n", balance, r);
-    }
-
-    r /= 12;
-    printf("$%.2lf\n", r);
+    s_total += b->cents;
+    //printf("balance = %.2lf, total = %.2lf\n", b->cents / 100.0, s_total / 100.0);
 }
 
-int main()
+static inline void mean()
 {
-    mean();
-    return 0;
+    // round half up to the nearest penny
+    int64_t r = (s_total + 6) / 12;
+    fio_put_char('$');
+    fio_put_fixed(r, 2);
+    fio_put_char('\n');
 }
 
+#define HARNESS_ITEM            balance_t
+#define HARNESS_PARSE(b)        read_balance(b)
+#define HARNESS_EMIT(b)         add_balance(b)
+#define HARNESS_END()           mean()
+#include "../common/harness.h"
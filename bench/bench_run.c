@@ -0,0 +1,219 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Runs one solver on a generated input, reports its throughput and compares it
+ * against the stored baseline.
+ *
+ * The solver is run with stdin redirected from the input file and stdout to
+ * /dev/null, and only its wall time is measured. The fastest of the given number
+ * of runs is kept to filter out scheduling noise. The run fails when the
+ * throughput drops more than the given tolerance below the baseline, so a
+ * slowdown is caught before it ships. Throughput only compares on the same
+ * machine, so the baseline lives in the build tree: a benchmark without an
+ * entry records its throughput as the baseline and passes. With --update the
+ * measured throughput always replaces the entry.
+ *
+ * [Usage]
+ *
+ * bench_run <name> <solver> <input> <items> <runs> <baseline> <tolerance> [--update]
+ *
+ * The baseline file holds one "<name> <items per second>" pair per line, lines
+ * starting with '#' are comments.
+ *==================================================================================
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define MAX_BASELINE_ENTRIES 64
+#define MAX_NAME_LENGTH      64
+
+typedef struct __baseline_entry {
+    char name[MAX_NAME_LENGTH];
+    double items_per_sec;
+} baseline_entry_t;
+
+typedef struct __baseline {
+    size_t count;
+    baseline_entry_t entries[MAX_BASELINE_ENTRIES];
+} baseline_t;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// wall time of one solver run in seconds, negative on failure
+static double run_solver(const char* solver, const char* input)
+{
+    int in = open(input, O_RDONLY);
+    if (in < 0) {
+        perror(input);
+        return -1.0;
+    }
+    int out = open("/dev/null", O_WRONLY);
+    if (out < 0) {
+        perror("/dev/null");
+        close(in);
+        return -1.0;
+    }
+
+    double start = now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(in, 0);
+        dup2(out, 1);
+        execl(solver, solver, (char*)0);
+        perror(solver);
+        _exit(127);
+    }
+    close(in);
+    close(out);
+    if (pid < 0) {
+        perror("fork");
+        return -1.0;
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) {
+        perror("waitpid");
+        return -1.0;
+    }
+    double elapsed = now() - start;
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "%s failed on %s\n", solver, input);
+        return -1.0;
+    }
+    return elapsed;
+}
+
+static void load_baseline(const char* path, baseline_t* baseline)
+{
+    baseline->count = 0;
+
+    FILE* f = fopen(path, "r");
+    if (!f) return;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f) && baseline->count < MAX_BASELINE_ENTRIES) {
+        if (line[0] == '#') continue;
+
+        baseline_entry_t* e = &baseline->entries[baseline->count];
+        if (sscanf(line, "%63s %lf", e->name, &e->items_per_sec) == 2) {
+            ++baseline->count;
+        }
+    }
+    fclose(f);
+}
+
+static bool save_baseline(const char* path, const baseline_t* baseline)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    fprintf(f, "# <benchmark> <items per second>, refreshed by the bench_update_baseline target\n");
+    size_t i;
+    for (i = 0; i < baseline->count; ++i) {
+        fprintf(f, "%s %.0f\n", baseline->entries[i].name, baseline->entries[i].items_per_sec);
+    }
+    return fclose(f) == 0;
+}
+
+static baseline_entry_t* find_baseline(baseline_t* baseline, const char* name)
+{
+    size_t i;
+    for (i = 0; i < baseline->count; ++i) {
+        if (strcmp(baseline->entries[i].name, name) == 0) return &baseline->entries[i];
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 8 && !(argc == 9 && strcmp(argv[8], "--update") == 0)) {
+        fprintf(stderr,
+                "usage: %s <name> <solver> <input> <items> <runs> <baseline> <tolerance> "
+                "[--update]\n", argv[0]);
+        return 1;
+    }
+
+    const char* name = argv[1];
+    const char* solver = argv[2];
+    const char* input = argv[3];
+    double items = strtod(argv[4], 0);
+    long runs = strtol(argv[5], 0, 10);
+    const char* baseline_path = argv[6];
+    double tolerance = strtod(argv[7], 0);
+    bool update = (argc == 9);
+
+    if (strlen(name) >= MAX_NAME_LENGTH) {
+        fprintf(stderr, "benchmark name too long: %s\n", name);
+        return 1;
+    }
+
+    struct stat st;
+    if (stat(input, &st) != 0) {
+        perror(input);
+        return 1;
+    }
+
+    double elapsed = 0.0;
+    long i;
+    for (i = 0; i < (runs > 0 ? runs : 1); ++i) {
+        double t = run_solver(solver, input);
+        if (t < 0) return 1;
+        if (i == 0 || t < elapsed) elapsed = t;
+    }
+    if (elapsed < 1e-6) elapsed = 1e-6;
+
+    double items_per_sec = items / elapsed;
+    double mb_per_sec = (double)st.st_size / (1024.0 * 1024.0) / elapsed;
+    printf("%-10s %10.0f items %8.1f MB in %7.3f s -> %12.0f items/s %8.1f MB/s",
+           name, items, (double)st.st_size / (1024.0 * 1024.0), elapsed,
+           items_per_sec, mb_per_sec);
+
+    baseline_t baseline;
+    load_baseline(baseline_path, &baseline);
+    baseline_entry_t* e = find_baseline(&baseline, name);
+
+    if (update || !e || e->items_per_sec <= 0) {
+        if (!e) {
+            if (baseline.count == MAX_BASELINE_ENTRIES) {
+                printf("\n");
+                fprintf(stderr, "too many baseline entries in %s\n", baseline_path);
+                return 1;
+            }
+            e = &baseline.entries[baseline.count++];
+            strcpy(e->name, name);
+        }
+        e->items_per_sec = items_per_sec;
+        printf(update ? ", baseline updated\n" : ", baseline recorded\n");
+        return save_baseline(baseline_path, &baseline) ? 0 : 1;
+    }
+
+    double change = (items_per_sec - e->items_per_sec) / e->items_per_sec;
+    printf(", baseline %.0f items/s (%+.1f%%)\n", e->items_per_sec, change * 100.0);
+    if (change < -tolerance) {
+        fflush(stdout);
+        fprintf(stderr, "%s regressed by %.1f%%, tolerance is %.1f%%\n",
+                name, -change * 100.0, tolerance * 100.0);
+        return 1;
+    }
+    return 0;
+}
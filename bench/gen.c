@@ -0,0 +1,172 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Seeded generator of production-scale benchmark inputs.
+ *
+ * The same problem, count and seed always produce the same file, on any platform,
+ * so benchmark numbers stay comparable with the stored baseline.
+ *
+ * [Usage]
+ *
+ * gen <problem> <count> <seed> <output>
+ *
+ * 1001: count lines of "R n" with R in 6 columns and large exponents
+ * 1001_mixed: count lines of "R n" with 0 < n <= 25, and one huge n in the middle
+ * 1002: count phone numbers in arbitrary forms, with plenty of duplicates
+ * 1003: count overhang queries in [0.01, 5.20], followed by 0.00
+ * 1004: count closing balances
+ *==================================================================================
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define GEN_1001_MIN_POWER  200
+#define GEN_1001_MAX_POWER  600
+#define GEN_1001_HUGE_POWER 30000
+
+static uint64_t s_state;
+
+// splitmix64, so the output does not depend on the libc rand()
+static uint64_t next_random()
+{
+    uint64_t z = (s_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// uniform in [low, high]
+static uint32_t random_range(uint32_t low, uint32_t high)
+{
+    return low + (uint32_t)(next_random() % ((uint64_t)high - low + 1));
+}
+
+// power is drawn after R, in [min_power, max_power]
+static void gen_1001_line(FILE* out, uint32_t min_power, uint32_t max_power)
+{
+    // R occupies exactly 6 columns: 1 or 2 integer digits, a point and the rest
+    char base[7];
+    uint32_t int_digits = random_range(1, 2);
+    char* p = base;
+    uint32_t i;
+    for (i = 0; i < 6; ++i) {
+        if (i == int_digits) *p++ = '.';
+        else *p++ = (char)('0' + random_range(0, 9));
+    }
+    *p = '\0';
+    if (int_digits == 2 && base[0] == '0') base[0] = '1';
+    if (base[int_digits + 1] == '0') base[int_digits + 1] = '1';
+
+    fprintf(out, "%s %u\n", base, random_range(min_power, max_power));
+}
+
+static void gen_1001(FILE* out, uint32_t count)
+{
+    while (count--) {
+        gen_1001_line(out, GEN_1001_MIN_POWER, GEN_1001_MAX_POWER);
+    }
+}
+
+// one huge power batched together with ordinary ones
+static void gen_1001_mixed(FILE* out, uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; ++i) {
+        if (i == count / 2) gen_1001_line(out, GEN_1001_HUGE_POWER, GEN_1001_HUGE_POWER);
+        else gen_1001_line(out, 1, 25);
+    }
+}
+
+static void gen_1002(FILE* out, uint32_t count)
+{
+    static const char* letters[10] = {
+        "", "", "ABC", "DEF", "GHI", "JKL", "MNO", "PRS", "TUV", "WXY"
+    };
+
+    // draw from a pool half the size of the directory, so duplicates are common
+    uint32_t pool = count / 2 ? count / 2 : 1;
+    uint32_t* numbers = (uint32_t*) malloc(sizeof(uint32_t) * pool);
+    if (!numbers) return;
+
+    uint32_t i;
+    for (i = 0; i < pool; ++i) {
+        numbers[i] = random_range(0, 9999999);
+    }
+
+    fprintf(out, "%u\n", count);
+    char line[32];
+    while (count--) {
+        uint32_t number = numbers[random_range(0, pool - 1)];
+        char digits[7];
+        int d;
+        for (d = 6; d >= 0; --d) {
+            digits[d] = (char)('0' + number % 10);
+            number /= 10;
+        }
+
+        char* p = line;
+        for (d = 0; d < 7; ++d) {
+            if (d && random_range(0, 3) == 0) *p++ = '-';
+
+            int digit = digits[d] - '0';
+            if (digit >= 2 && random_range(0, 1)) *p++ = letters[digit][random_range(0, 2)];
+            else *p++ = digits[d];
+        }
+        *p++ = '\n';
+        fwrite(line, 1, (size_t)(p - line), out);
+    }
+
+    free(numbers);
+}
+
+static void gen_1003(FILE* out, uint32_t count)
+{
+    while (count--) {
+        uint32_t c = random_range(1, 520);
+        fprintf(out, "%u.%02u\n", c / 100, c % 100);
+    }
+    fprintf(out, "0.00\n");
+}
+
+static void gen_1004(FILE* out, uint32_t count)
+{
+    while (count--) {
+        fprintf(out, "%u.%02u\n", random_range(0, 999999), random_range(0, 99));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 5) {
+        fprintf(stderr, "usage: %s <problem> <count> <seed> <output>\n", argv[0]);
+        return 1;
+    }
+
+    const char* problem = argv[1];
+    uint32_t count = (uint32_t)strtoul(argv[2], 0, 10);
+    s_state = (uint64_t)strtoull(argv[3], 0, 10);
+
+    FILE* out = fopen(argv[4], "wb");
+    if (!out) {
+        perror(argv[4]);
+        return 1;
+    }
+
+    int r = 0;
+    if (strcmp(problem, "1001") == 0) gen_1001(out, count);
+    else if (strcmp(problem, "1001_mixed") == 0) gen_1001_mixed(out, count);
+    else if (strcmp(problem, "1002") == 0) gen_1002(out, count);
+    else if (strcmp(problem, "1003") == 0) gen_1003(out, count);
+    else if (strcmp(problem, "1004") == 0) gen_1004(out, count);
+    else {
+        fprintf(stderr, "unknown problem: %s\n", problem);
+        r = 1;
+    }
+
+    if (fclose(out) != 0) r = 1;
+    return r;
+}
@@ -0,0 +1,22 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Small helpers shared by all solutions.
+ *==================================================================================
+ */
+
+#ifndef POJ_COMMON_COMMON_H
+#define POJ_COMMON_COMMON_H
+
+#include <stdlib.h>
+
+#define SAFE_RELEASE(x) \
+    do { \
+        if ((x)) { \
+            free((x)); \
+            (x) = 0; \
+        } \
+    } while (0)
+
+#endif // POJ_COMMON_COMMON_H
@@ -0,0 +1,361 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Buffered fast I/O shared by all solutions.
+ *
+ * Input is taken from fd 0. When stdin is a regular file it is mapped into memory
+ * as a whole, otherwise it is read in large blocks into a refillable buffer.
+ * Output is collected into a large buffer and written to fd 1 in big blocks, so a
+ * solution never goes through stdio for each token or each line.
+ *
+ * Everything is static inline so a solution stays a single translation unit:
+ * include this header, call fio_init() first and fio_fini() last.
+ *==================================================================================
+ */
+
+#ifndef POJ_COMMON_FASTIO_H
+#define POJ_COMMON_FASTIO_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#ifndef FIO_IN_BUFFER_SIZE
+#define FIO_IN_BUFFER_SIZE  (1 << 16)
+#endif
+
+#ifndef FIO_OUT_BUFFER_SIZE
+#define FIO_OUT_BUFFER_SIZE (1 << 16)
+#endif
+
+typedef struct __fio_reader {
+    const char* cur;
+    const char* end;
+    char* buf;          // refill buffer, unused when mapped
+    void* map;          // whole-file mapping of stdin, or 0
+    size_t map_size;
+    bool eof;
+} fio_reader_t;
+
+typedef struct __fio_writer {
+    char* cur;
+    char buf[FIO_OUT_BUFFER_SIZE];
+} fio_writer_t;
+
+static fio_reader_t s_fio_in;
+static fio_writer_t s_fio_out;
+
+static inline void fio_init()
+{
+    memset(&s_fio_in, 0, sizeof(s_fio_in));
+    s_fio_out.cur = s_fio_out.buf;
+
+    // stdin may already be partly consumed by whoever handed it over,
+    // so the mapping is read from the current offset on
+    struct stat st;
+    off_t off = lseek(0, 0, SEEK_CUR);
+    if (fstat(0, &st) == 0 && S_ISREG(st.st_mode) && off >= 0 && off < st.st_size) {
+        void* map = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, 0, 0);
+        if (map != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            s_fio_in.map = map;
+            s_fio_in.map_size = (size_t)st.st_size;
+            s_fio_in.cur = (const char*)map + off;
+            s_fio_in.end = (const char*)map + s_fio_in.map_size;
+            s_fio_in.eof = true;
+            return;
+        }
+    }
+
+    // pipe, terminal or unmappable file: fall back to block reads
+    s_fio_in.buf = (char*) malloc(FIO_IN_BUFFER_SIZE);
+    if (!s_fio_in.buf) {
+        s_fio_in.eof = true;
+        return;
+    }
+    s_fio_in.cur = s_fio_in.end = s_fio_in.buf;
+}
+
+static inline bool fio_refill()
+{
+    if (s_fio_in.eof) return false;
+
+    ssize_t n;
+    do {
+        n = read(0, s_fio_in.buf, FIO_IN_BUFFER_SIZE);
+    } while (n < 0 && errno == EINTR);
+
+    if (n <= 0) {
+        s_fio_in.eof = true;
+        return false;
+    }
+    s_fio_in.cur = s_fio_in.buf;
+    s_fio_in.end = s_fio_in.buf + n;
+    return true;
+}
+
+// -1 on end of input
+static inline int fio_peek()
+{
+    if (s_fio_in.cur == s_fio_in.end && !fio_refill()) return -1;
+    return (unsigned char)*s_fio_in.cur;
+}
+
+static inline int fio_getc()
+{
+    if (s_fio_in.cur == s_fio_in.end && !fio_refill()) return -1;
+    return (unsigned char)*s_fio_in.cur++;
+}
+
+static inline bool fio_is_space(int c)
+{
+    return (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f');
+}
+
+// skip white spaces, return the first non-space character without consuming it
+static inline int fio_skip_space()
+{
+    int c;
+    while ((c = fio_peek()) != -1 && fio_is_space(c)) ++s_fio_in.cur;
+    return c;
+}
+
+// read a white space delimited token like scanf("%s"), truncated to size - 1
+// characters, returns its length or -1 on end of input
+static inline long fio_read_token(char* token, size_t size)
+{
+    if (fio_skip_space() == -1) return -1;
+
+    size_t len = 0;
+    int c;
+    while ((c = fio_peek()) != -1 && !fio_is_space(c)) {
+        if (len + 1 < size) token[len++] = (char)c;
+        ++s_fio_in.cur;
+    }
+    if (size) token[len] = '\0';
+    return (long)len;
+}
+
+// the number readers return false at end of input and when no digit follows,
+// so a loop reading numbers always stops on malformed input instead of spinning
+static inline bool fio_read_u32(uint32_t* n)
+{
+    int c = fio_skip_space();
+    if (c < '0' || c > '9') return false;
+
+    uint32_t r = 0;
+    while ((c = fio_peek()) >= '0' && c <= '9') {
+        r = r * 10 + (uint32_t)(c - '0');
+        ++s_fio_in.cur;
+    }
+
+    *n = r;
+    return true;
+}
+
+static inline bool fio_read_long(long* n)
+{
+    int c = fio_skip_space();
+    if (c == -1) return false;
+
+    bool negative = false;
+    if (c == '-' || c == '+') {
+        negative = (c == '-');
+        ++s_fio_in.cur;
+    }
+
+    c = fio_peek();
+    if (c < '0' || c > '9') return false;
+
+    long r = 0;
+    while ((c = fio_peek()) >= '0' && c <= '9') {
+        r = r * 10 + (c - '0');
+        ++s_fio_in.cur;
+    }
+
+    *n = negative ? -r : r;
+    return true;
+}
+
+// read a decimal like 1234.56 as a fixed point integer scaled by 10^scale,
+// extra fraction digits are truncated (e.g. scale 2: "3.719" -> 371)
+static inline bool fio_read_fixed(int64_t* n, unsigned scale)
+{
+    int c = fio_skip_space();
+    if (c == -1) return false;
+
+    bool negative = false;
+    if (c == '-' || c == '+') {
+        negative = (c == '-');
+        ++s_fio_in.cur;
+    }
+
+    // checked once up front rather than counting every digit
+    c = fio_peek();
+    bool digits = (c >= '0' && c <= '9');
+
+    int64_t r = 0;
+    while ((c = fio_peek()) >= '0' && c <= '9') {
+        r = r * 10 + (c - '0');
+        ++s_fio_in.cur;
+    }
+
+    unsigned fraction = 0;
+    if (c == '.') {
+        ++s_fio_in.cur;
+        if (!digits) {
+            c = fio_peek();
+            digits = (c >= '0' && c <= '9');
+        }
+        while ((c = fio_peek()) >= '0' && c <= '9') {
+            if (fraction < scale) {
+                r = r * 10 + (c - '0');
+                ++fraction;
+            }
+            ++s_fio_in.cur;
+        }
+    }
+    if (!digits) return false;
+    while (fraction++ < scale) r *= 10;
+
+    *n = negative ? -r : r;
+    return true;
+}
+
+static inline void fio_flush()
+{
+    const char* p = s_fio_out.buf;
+    while (p < s_fio_out.cur) {
+        ssize_t n = write(1, p, (size_t)(s_fio_out.cur - p));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        p += n;
+    }
+    s_fio_out.cur = s_fio_out.buf;
+}
+
+// make sure at least size bytes are available in the output buffer,
+// size must not exceed FIO_OUT_BUFFER_SIZE
+static inline void fio_reserve(size_t size)
+{
+    if ((size_t)(s_fio_out.buf + FIO_OUT_BUFFER_SIZE - s_fio_out.cur) < size) {
+        fio_flush();
+    }
+}
+
+static inline void fio_put_char(char c)
+{
+    fio_reserve(1);
+    *s_fio_out.cur++ = c;
+}
+
+static inline void fio_put_mem(const char* s, size_t size)
+{
+    while (size > 0) {
+        size_t room = (size_t)(s_fio_out.buf + FIO_OUT_BUFFER_SIZE - s_fio_out.cur);
+        if (room == 0) {
+            fio_flush();
+            continue;
+        }
+        size_t n = size < room ? size : room;
+        memcpy(s_fio_out.cur, s, n);
+        s_fio_out.cur += n;
+        s += n;
+        size -= n;
+    }
+}
+
+static inline void fio_put_str(const char* s)
+{
+    fio_put_mem(s, strlen(s));
+}
+
+// write n in decimal, left padded with zeros up to width digits like "%0*u"
+static inline void fio_put_u64_width(uint64_t n, unsigned width)
+{
+    char digits[20];
+    char* p = digits + sizeof(digits);
+    do {
+        *--p = (char)('0' + n % 10);
+        n /= 10;
+    } while (n);
+
+    size_t len = (size_t)(digits + sizeof(digits) - p);
+    fio_reserve((width > len ? width : len));
+    while (width > len) {
+        *s_fio_out.cur++ = '0';
+        --width;
+    }
+    memcpy(s_fio_out.cur, p, len);
+    s_fio_out.cur += len;
+}
+
+static inline void fio_put_u32(uint32_t n)
+{
+    fio_put_u64_width(n, 0);
+}
+
+static inline void fio_put_u32_width(uint32_t n, unsigned width)
+{
+    fio_put_u64_width(n, width);
+}
+
+static inline void fio_put_long(long n)
+{
+    if (n < 0) {
+        fio_put_char('-');
+        fio_put_u64_width((uint64_t)0 - (uint64_t)n, 0);
+    }
+    else {
+        fio_put_u64_width((uint64_t)n, 0);
+    }
+}
+
+// write a fixed point integer scaled by 10^scale as a decimal with exactly
+// scale fraction digits (e.g. scale 2: 158142 -> "1581.42")
+static inline void fio_put_fixed(int64_t n, unsigned scale)
+{
+    uint64_t u = (uint64_t)n;
+    if (n < 0) {
+        fio_put_char('-');
+        u = (uint64_t)0 - u;
+    }
+
+    uint64_t divisor = 1;
+    for (unsigned i = 0; i < scale; ++i) divisor *= 10;
+
+    fio_put_u64_width(u / divisor, 0);
+    if (scale) {
+        fio_put_char('.');
+        fio_put_u64_width(u % divisor, scale);
+    }
+}
+
+static inline void fio_fini()
+{
+    fio_flush();
+    if (s_fio_in.map) {
+        // leave fd 0 right after the consumed input, for whoever reads it next
+        lseek(0, (off_t)(s_fio_in.cur - (const char*)s_fio_in.map), SEEK_SET);
+        munmap(s_fio_in.map, s_fio_in.map_size);
+        s_fio_in.map = 0;
+    }
+    if (s_fio_in.buf) {
+        free(s_fio_in.buf);
+        s_fio_in.buf = 0;
+    }
+    s_fio_in.cur = s_fio_in.end = 0;
+}
+
+#endif // POJ_COMMON_FASTIO_H
@@ -0,0 +1,229 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Generic solver harness shared by all solutions.
+ *
+ * A solution describes how to handle one item of input and the harness supplies
+ * main(): fast I/O, batching, an optional thread pool and instrumentation. The
+ * callbacks are plain macros naming functions of the solution, so every call is
+ * a direct call the compiler can inline.
+ *
+ * A solution with HARNESS_COMPUTE has its items staged in batches, so parsing,
+ * computing and emitting each run as a tight loop and a batch can be computed
+ * on the pool. Without it every item is emitted right after it is parsed,
+ * exactly like a hand written input loop.
+ *
+ * Include it at the end of the solution, once the callbacks are declared, after
+ * defining:
+ *
+ * HARNESS_ITEM             type holding one item of input and its result
+ * HARNESS_PARSE(item)      read the next item, false at end of input
+ * HARNESS_EMIT(item)       write or accumulate the result, called in input order
+ *
+ * Optionally:
+ *
+ * HARNESS_COMPUTE(item)    solve one item, may run on any thread of the pool
+ * HARNESS_BEGIN()          called after fio_init() and before the first item
+ * HARNESS_END()            called after the last item and before fio_fini()
+ * HARNESS_BATCH_SIZE       items parsed before they are computed, default 256
+ * HARNESS_THREADS          threads computing a batch, 0 for one per online CPU,
+ *                          default 1 (no pthreads)
+ * PERF_MEASURE             report item count and time spent per phase on stderr
+ *==================================================================================
+ */
+
+#ifndef POJ_COMMON_HARNESS_H
+#define POJ_COMMON_HARNESS_H
+
+#include "common.h"
+#include "fastio.h"
+
+#if !defined(HARNESS_ITEM) || !defined(HARNESS_PARSE) || !defined(HARNESS_EMIT)
+#error "HARNESS_ITEM, HARNESS_PARSE and HARNESS_EMIT must be defined before harness.h"
+#endif
+
+#ifndef HARNESS_BATCH_SIZE
+#define HARNESS_BATCH_SIZE 256
+#endif
+
+#ifndef HARNESS_THREADS
+#define HARNESS_THREADS 1
+#endif
+
+#if HARNESS_THREADS != 1
+#include "thread_pool.h"
+#endif
+
+#ifdef PERF_MEASURE
+#include <stdio.h>
+#include <time.h>
+
+typedef struct __harness_perf {
+    uint64_t items;
+    uint64_t batches;
+    uint64_t parse_ns;
+    uint64_t compute_ns;
+    uint64_t emit_ns;
+} harness_perf_t;
+
+static harness_perf_t s_harness_perf;
+
+static inline uint64_t harness_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#define HARNESS_PERF_START()        uint64_t harness_t0 = harness_now_ns()
+#define HARNESS_PERF_STOP(counter) \
+    do { \
+        uint64_t harness_t1 = harness_now_ns(); \
+        s_harness_perf.counter += harness_t1 - harness_t0; \
+        harness_t0 = harness_t1; \
+    } while (0)
+#define HARNESS_PERF_COUNT(n) \
+    do { \
+        s_harness_perf.items += (n); \
+        ++s_harness_perf.batches; \
+    } while (0)
+
+static void harness_perf_report()
+{
+#ifdef HARNESS_COMPUTE
+    fprintf(stderr,
+            "harness: %" PRIu64 " item(s) in %" PRIu64 " batch(es), "
+            "parse %.3f ms, compute %.3f ms, emit %.3f ms\n",
+            s_harness_perf.items, s_harness_perf.batches,
+            s_harness_perf.parse_ns / 1e6, s_harness_perf.compute_ns / 1e6,
+            s_harness_perf.emit_ns / 1e6);
+#else
+    // parse and emit interleave per item, timing each of them would dwarf the work
+    fprintf(stderr, "harness: %" PRIu64 " item(s) in %.3f ms\n",
+            s_harness_perf.items, s_harness_perf.parse_ns / 1e6);
+#endif
+}
+#else
+#define HARNESS_PERF_START()        do {} while (0)
+#define HARNESS_PERF_STOP(counter)  do {} while (0)
+#define HARNESS_PERF_COUNT(n)       do {} while (0)
+#endif // PERF_MEASURE
+
+#ifdef HARNESS_COMPUTE
+static HARNESS_ITEM s_harness_batch[HARNESS_BATCH_SIZE];
+
+#if HARNESS_THREADS != 1
+static thread_pool_t* s_harness_pool;
+
+typedef struct __harness_chunks {
+    size_t count;
+    size_t chunk_size;
+} harness_chunks_t;
+
+static void harness_compute_chunk(void* ctx, size_t index)
+{
+    const harness_chunks_t* chunks = (const harness_chunks_t*)ctx;
+    size_t begin = index * chunks->chunk_size;
+    size_t end = begin + chunks->chunk_size;
+    if (end > chunks->count) end = chunks->count;
+
+    size_t i;
+    for (i = begin; i < end; ++i) {
+        HARNESS_COMPUTE(&s_harness_batch[i]);
+    }
+}
+
+static inline void harness_compute(size_t count)
+{
+    // a few chunks per thread, so one slow item does not hold up the batch
+    size_t num_chunks = tp_size(s_harness_pool) * 4;
+    harness_chunks_t chunks;
+    chunks.count = count;
+    chunks.chunk_size = (count + num_chunks - 1) / num_chunks;
+    tp_run(s_harness_pool, (count + chunks.chunk_size - 1) / chunks.chunk_size,
+           harness_compute_chunk, &chunks);
+}
+#else
+static inline void harness_compute(size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; ++i) {
+        HARNESS_COMPUTE(&s_harness_batch[i]);
+    }
+}
+#endif // HARNESS_THREADS != 1
+
+static inline void harness_run()
+{
+    bool more = true;
+    while (more) {
+        HARNESS_PERF_START();
+
+        size_t count = 0;
+        while (count < HARNESS_BATCH_SIZE) {
+            if (!HARNESS_PARSE(&s_harness_batch[count])) {
+                more = false;
+                break;
+            }
+            ++count;
+        }
+        if (count == 0) break;
+        HARNESS_PERF_STOP(parse_ns);
+
+        harness_compute(count);
+        HARNESS_PERF_STOP(compute_ns);
+
+        size_t i;
+        for (i = 0; i < count; ++i) {
+            HARNESS_EMIT(&s_harness_batch[i]);
+        }
+        HARNESS_PERF_STOP(emit_ns);
+        HARNESS_PERF_COUNT(count);
+    }
+}
+#else
+// nothing to compute, so nothing is gained by staging items in a batch
+static inline void harness_run()
+{
+    HARNESS_PERF_START();
+
+    HARNESS_ITEM item;
+    uint64_t count = 0;
+    while (HARNESS_PARSE(&item)) {
+        HARNESS_EMIT(&item);
+        ++count;
+    }
+    (void)count;
+
+    HARNESS_PERF_STOP(parse_ns);
+    HARNESS_PERF_COUNT(count);
+}
+#endif // HARNESS_COMPUTE
+
+int main()
+{
+    fio_init();
+#if HARNESS_THREADS != 1 && defined(HARNESS_COMPUTE)
+    s_harness_pool = tp_create(HARNESS_THREADS);
+#endif
+#ifdef HARNESS_BEGIN
+    HARNESS_BEGIN();
+#endif
+
+    harness_run();
+
+#ifdef HARNESS_END
+    HARNESS_END();
+#endif
+#if HARNESS_THREADS != 1 && defined(HARNESS_COMPUTE)
+    tp_destroy(s_harness_pool);
+#endif
+    fio_fini();
+#ifdef PERF_MEASURE
+    harness_perf_report();
+#endif
+    return 0;
+}
+
+#endif // POJ_COMMON_HARNESS_H
@@ -0,0 +1,166 @@
+/*
+ *==================================================================================
+ * [Description]
+ *
+ * Minimal fork-join thread pool shared by all solutions.
+ *
+ * tp_run() calls task(ctx, i) for every i in [0, count) and returns once all of
+ * them are done. The calling thread works on the tasks too, so a pool of n
+ * threads starts only n - 1 workers. Tasks are handed out one index at a time,
+ * so uneven tasks balance themselves.
+ *
+ * A tp_run() issued from inside a task handed to the workers runs serially on
+ * the calling thread, nested parallel code therefore never deadlocks on a pool.
+ *==================================================================================
+ */
+
+#ifndef POJ_COMMON_THREAD_POOL_H
+#define POJ_COMMON_THREAD_POOL_H
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+
+typedef void (*tp_task_t)(void* ctx, size_t index);
+
+typedef struct __thread_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t idle;
+    pthread_t* workers;
+    size_t num_workers;
+    uint64_t generation;    // bumped for every tp_run()
+    size_t busy;            // workers still inside the current generation
+    bool stop;
+
+    tp_task_t task;
+    void* ctx;
+    size_t count;
+    size_t next;            // next task index, taken atomically
+} thread_pool_t;
+
+// nesting depth of tasks on the current thread
+static __thread unsigned s_tp_depth;
+
+static inline void tp_work(thread_pool_t* pool)
+{
+    ++s_tp_depth;
+    size_t i;
+    while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->count) {
+        pool->task(pool->ctx, i);
+    }
+    --s_tp_depth;
+}
+
+static void* tp_worker(void* arg)
+{
+    thread_pool_t* pool = (thread_pool_t*)arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stop) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        tp_work(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->idle);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+static inline void tp_destroy(thread_pool_t* pool);
+
+// num_threads counts the calling thread, 0 means one per online CPU
+static inline thread_pool_t* tp_create(size_t num_threads)
+{
+    if (num_threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = n > 0 ? (size_t)n : 1;
+    }
+
+    thread_pool_t* pool = (thread_pool_t*) calloc(1, sizeof(thread_pool_t));
+    if (!pool) return 0;
+
+    pthread_mutex_init(&pool->lock, 0);
+    pthread_cond_init(&pool->wake, 0);
+    pthread_cond_init(&pool->idle, 0);
+
+    if (num_threads > 1) {
+        pool->workers = (pthread_t*) malloc(sizeof(pthread_t) * (num_threads - 1));
+        if (!pool->workers) {
+            tp_destroy(pool);
+            return 0;
+        }
+        while (pool->num_workers < num_threads - 1) {
+            if (pthread_create(&pool->workers[pool->num_workers], 0, tp_worker, pool) != 0) break;
+            ++pool->num_workers;
+        }
+    }
+    return pool;
+}
+
+// number of threads working on a tp_run(), including the caller
+static inline size_t tp_size(const thread_pool_t* pool)
+{
+    return pool ? pool->num_workers + 1 : 1;
+}
+
+static inline void tp_run(thread_pool_t* pool, size_t count, tp_task_t task, void* ctx)
+{
+    if (!pool || pool->num_workers == 0 || count < 2 || s_tp_depth > 0) {
+        // the pool stays idle, so tasks run inline may still use a pool themselves
+        size_t i;
+        for (i = 0; i < count; ++i) task(ctx, i);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->count = count;
+    pool->next = 0;
+    pool->busy = pool->num_workers;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    tp_work(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static inline void tp_destroy(thread_pool_t* pool)
+{
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    size_t i;
+    for (i = 0; i < pool->num_workers; ++i) {
+        pthread_join(pool->workers[i], 0);
+    }
+
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+#endif // POJ_COMMON_THREAD_POOL_H
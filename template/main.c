@@ -16,9 +16,36 @@
 #include <assert.h>
 #include <string.h>
 #include <math.h>
+#include <inttypes.h>
+#include <stdbool.h>
 
-int main()
+#include "../common/common.h"
+#include "../common/fastio.h"
+
+typedef struct __item {
+    long input;
+    long result;
+} item_t;
+
+static inline bool parse_item(item_t* item)
+{
+    return fio_read_long(&item->input);
+}
+
+static inline void compute_item(item_t* item)
 {
-    return 0;
+    item->result = item->input;
 }
 
+static inline void emit_item(item_t* item)
+{
+    fio_put_long(item->result);
+    fio_put_char('\n');
+}
+
+#define HARNESS_ITEM            item_t
+#define HARNESS_PARSE(item)     parse_item(item)
+#define HARNESS_COMPUTE(item)   compute_item(item)
+#define HARNESS_EMIT(item)      emit_item(item)
+#include "../common/harness.h"
+